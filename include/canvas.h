@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// An image uploaded to a canvas: either an opaque picture (the background) or
+// a glyph coverage mask that is tinted when drawn.
+class CanvasImage {
+public:
+    virtual ~CanvasImage() {}
+    int w = 0;
+    int h = 0;
+};
+
+// The drawing operations the game uses, so frames can be composed either by an
+// SDL_Renderer or by the CPU backend below. Mirrors the SDL_Render* calls it
+// replaces: the draw color is sticky and ignores alpha except for glyphs.
+class Canvas {
+public:
+    virtual ~Canvas() {}
+
+    virtual void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) = 0;
+    virtual void clear() = 0;
+    virtual void drawPoints(const SDL_Point* points, int count) = 0;
+    virtual void drawLine(int x1, int y1, int x2, int y2) = 0;
+    virtual void fillRect(const SDL_Rect& rect) = 0;
+    virtual void drawRect(const SDL_Rect& rect) = 0;
+
+    // The surface is copied; the caller still owns it.
+    virtual std::unique_ptr<CanvasImage> createImage(SDL_Surface* surface) = 0;
+    virtual std::unique_ptr<CanvasImage> createGlyph(SDL_Surface* surface) = 0;
+    virtual void drawImage(const CanvasImage& image, int x, int y) = 0;
+    virtual void drawGlyph(const CanvasImage& glyph, int x, int y, SDL_Color color) = 0;
+
+    virtual void present() = 0;
+
+    // Makes the next present() repaint the whole window, e.g. after it was
+    // exposed again and its contents may have been lost.
+    virtual void invalidate() = 0;
+};
+
+// Kernel sets for the CPU backend. Best picks AVX2 or SSE2 by what the CPU
+// supports; the others are there so the benchmark can compare them.
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,
+    Best
+};
+
+bool simdLevelSupported(SimdLevel level);
+std::string simdLevelName(SimdLevel level);
+
+// Draws through an existing renderer; the renderer is not owned.
+std::unique_ptr<Canvas> createRendererCanvas(SDL_Renderer* renderer);
+
+// Composes frames in a CPU framebuffer and copies only the regions that changed
+// since the last present to the window surface. The window must not have an
+// SDL_Renderer. A null window composes off-screen (used by the benchmark).
+std::unique_ptr<Canvas> createSoftwareCanvas(SDL_Window* window, int width, int height, SimdLevel level);
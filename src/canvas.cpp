@@ -0,0 +1,541 @@
+#include "canvas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CANVAS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Span kernels. All pixels are ARGB8888 words; coverage is one byte per pixel.
+
+typedef void (*FillSpanFn)(Uint32* dst, int n, Uint32 color);
+typedef void (*CopySpanFn)(Uint32* dst, const Uint32* src, int n);
+typedef void (*BlendSpanFn)(Uint32* dst, const Uint8* coverage, int n, Uint32 color);
+
+struct Kernels {
+    FillSpanFn fill;
+    CopySpanFn copy;
+    BlendSpanFn blend;
+};
+
+// (s * a + d * (255 - a)) / 255 per channel, rounded. The 16-bit sum never
+// exceeds 255 * 255, which is what lets the SIMD versions stay in 16-bit lanes.
+static inline Uint32 blendPixel(Uint32 d, Uint32 s, Uint32 a) {
+    Uint32 out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        Uint32 t = ((s >> shift) & 0xFF) * a + ((d >> shift) & 0xFF) * (255 - a) + 128;
+        out |= ((t + (t >> 8)) >> 8) << shift;
+    }
+    return out;
+}
+
+static void fillSpanScalar(Uint32* dst, int n, Uint32 color) {
+    for (int i = 0; i < n; i++)
+        dst[i] = color;
+}
+
+static void copySpanScalar(Uint32* dst, const Uint32* src, int n) {
+    memcpy(dst, src, n * sizeof(Uint32));
+}
+
+static void blendSpanScalar(Uint32* dst, const Uint8* coverage, int n, Uint32 color) {
+    for (int i = 0; i < n; i++) {
+        Uint32 a = coverage[i];
+        if (a == 255)
+            dst[i] = color;
+        else if (a)
+            dst[i] = blendPixel(dst[i], color, a);
+    }
+}
+
+#ifdef CANVAS_X86
+
+__attribute__((target("sse2")))
+static void fillSpanSSE2(Uint32* dst, int n, Uint32 color) {
+    __m128i v = _mm_set1_epi32(static_cast<int>(color));
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    fillSpanScalar(dst + i, n - i, color);
+}
+
+__attribute__((target("sse2")))
+static void copySpanSSE2(Uint32* dst, const Uint32* src, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    copySpanScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i blendHalfSSE2(__m128i d, __m128i s, __m128i a) {
+    __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, inv));
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("sse2")))
+static void blendSpanSSE2(Uint32* dst, const Uint8* coverage, int n, Uint32 color) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i solid = _mm_set1_epi32(static_cast<int>(color));
+    const __m128i s = _mm_unpacklo_epi8(solid, zero);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        Uint32 c;
+        memcpy(&c, coverage + i, 4);
+        if (c == 0)
+            continue;
+        __m128i* p = reinterpret_cast<__m128i*>(dst + i);
+        if (c == 0xFFFFFFFFu) {
+            _mm_storeu_si128(p, solid);
+            continue;
+        }
+        // Broadcast each pixel's coverage byte to its four channels.
+        __m128i a = _mm_cvtsi32_si128(static_cast<int>(c));
+        a = _mm_unpacklo_epi8(a, a);
+        a = _mm_unpacklo_epi16(a, a);
+        __m128i d = _mm_loadu_si128(p);
+        __m128i lo = blendHalfSSE2(_mm_unpacklo_epi8(d, zero), s, _mm_unpacklo_epi8(a, zero));
+        __m128i hi = blendHalfSSE2(_mm_unpackhi_epi8(d, zero), s, _mm_unpackhi_epi8(a, zero));
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    blendSpanScalar(dst + i, coverage + i, n - i, color);
+}
+
+__attribute__((target("avx2")))
+static void fillSpanAVX2(Uint32* dst, int n, Uint32 color) {
+    __m256i v = _mm256_set1_epi32(static_cast<int>(color));
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    fillSpanScalar(dst + i, n - i, color);
+}
+
+__attribute__((target("avx2")))
+static void copySpanAVX2(Uint32* dst, const Uint32* src, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    copySpanScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i blendHalfAVX2(__m256i d, __m256i s, __m256i a) {
+    __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, inv));
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+static void blendSpanAVX2(Uint32* dst, const Uint8* coverage, int n, Uint32 color) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i solid = _mm256_set1_epi32(static_cast<int>(color));
+    const __m256i s = _mm256_unpacklo_epi8(solid, zero);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        Uint64 c;
+        memcpy(&c, coverage + i, 8);
+        if (c == 0)
+            continue;
+        __m256i* p = reinterpret_cast<__m256i*>(dst + i);
+        if (c == ~Uint64(0)) {
+            _mm256_storeu_si256(p, solid);
+            continue;
+        }
+        // Widen the eight coverage bytes to one per 32-bit lane, then copy
+        // each into all four bytes of its lane.
+        __m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(coverage + i)));
+        a = _mm256_mullo_epi32(a, _mm256_set1_epi32(0x01010101));
+        __m256i d = _mm256_loadu_si256(p);
+        __m256i lo = blendHalfAVX2(_mm256_unpacklo_epi8(d, zero), s, _mm256_unpacklo_epi8(a, zero));
+        __m256i hi = blendHalfAVX2(_mm256_unpackhi_epi8(d, zero), s, _mm256_unpackhi_epi8(a, zero));
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    blendSpanSSE2(dst + i, coverage + i, n - i, color);
+}
+
+#endif
+
+bool simdLevelSupported(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+    case SimdLevel::Best:
+        return true;
+#ifdef CANVAS_X86
+    case SimdLevel::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case SimdLevel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+static SimdLevel resolveSimdLevel(SimdLevel level) {
+    if (level != SimdLevel::Best)
+        return simdLevelSupported(level) ? level : SimdLevel::Scalar;
+    if (simdLevelSupported(SimdLevel::AVX2))
+        return SimdLevel::AVX2;
+    if (simdLevelSupported(SimdLevel::SSE2))
+        return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+}
+
+string simdLevelName(SimdLevel level) {
+    switch (resolveSimdLevel(level)) {
+    case SimdLevel::SSE2:
+        return "sse2";
+    case SimdLevel::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+static Kernels kernelsFor(SimdLevel level) {
+    switch (resolveSimdLevel(level)) {
+#ifdef CANVAS_X86
+    case SimdLevel::SSE2:
+        return {fillSpanSSE2, copySpanSSE2, blendSpanSSE2};
+    case SimdLevel::AVX2:
+        return {fillSpanAVX2, copySpanAVX2, blendSpanAVX2};
+#endif
+    default:
+        return {fillSpanScalar, copySpanScalar, blendSpanScalar};
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SDL_Renderer backend.
+
+class RendererCanvas : public Canvas {
+public:
+    explicit RendererCanvas(SDL_Renderer* renderer) : renderer(renderer) {}
+
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) override {
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    }
+
+    void clear() override {
+        SDL_RenderClear(renderer);
+    }
+
+    void drawPoints(const SDL_Point* points, int count) override {
+        SDL_RenderDrawPoints(renderer, points, count);
+    }
+
+    void drawLine(int x1, int y1, int x2, int y2) override {
+        SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+    }
+
+    void fillRect(const SDL_Rect& rect) override {
+        SDL_RenderFillRect(renderer, &rect);
+    }
+
+    void drawRect(const SDL_Rect& rect) override {
+        SDL_RenderDrawRect(renderer, &rect);
+    }
+
+    unique_ptr<CanvasImage> createImage(SDL_Surface* surface) override {
+        return createTexture(surface);
+    }
+
+    unique_ptr<CanvasImage> createGlyph(SDL_Surface* surface) override {
+        return createTexture(surface);
+    }
+
+    void drawImage(const CanvasImage& image, int x, int y) override {
+        SDL_Rect dst = {x, y, image.w, image.h};
+        SDL_RenderCopy(renderer, static_cast<const TextureImage&>(image).texture, NULL, &dst);
+    }
+
+    void drawGlyph(const CanvasImage& glyph, int x, int y, SDL_Color color) override {
+        SDL_Texture* texture = static_cast<const TextureImage&>(glyph).texture;
+        SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(texture, color.a);
+        SDL_Rect dst = {x, y, glyph.w, glyph.h};
+        SDL_RenderCopy(renderer, texture, NULL, &dst);
+    }
+
+    void present() override {
+        SDL_RenderPresent(renderer);
+    }
+
+    // Every present already sends the whole frame.
+    void invalidate() override {}
+
+private:
+    struct TextureImage : CanvasImage {
+        SDL_Texture* texture = nullptr;
+        ~TextureImage() override {
+            SDL_DestroyTexture(texture);
+        }
+    };
+
+    unique_ptr<CanvasImage> createTexture(SDL_Surface* surface) {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (!texture)
+            return nullptr;
+        auto image = make_unique<TextureImage>();
+        image->texture = texture;
+        image->w = surface->w;
+        image->h = surface->h;
+        return image;
+    }
+
+    SDL_Renderer* renderer;
+};
+
+unique_ptr<Canvas> createRendererCanvas(SDL_Renderer* renderer) {
+    return make_unique<RendererCanvas>(renderer);
+}
+
+// ---------------------------------------------------------------------------
+// CPU backend.
+
+class SoftwareCanvas : public Canvas {
+public:
+    SoftwareCanvas(SDL_Window* window, int width, int height, SimdLevel level)
+        : window(window), width(width), height(height),
+          pixels(width * height, 0xFF000000u), shown(width * height, 0),
+          kernels(kernelsFor(level)) {
+        frame = SDL_CreateRGBSurfaceWithFormatFrom(pixels.data(), width, height, 32, width * 4, SDL_PIXELFORMAT_ARGB8888);
+        if (frame)
+            SDL_SetSurfaceBlendMode(frame, SDL_BLENDMODE_NONE);
+    }
+
+    ~SoftwareCanvas() override {
+        SDL_FreeSurface(frame);
+    }
+
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8) override {
+        color = 0xFF000000u | (Uint32(r) << 16) | (Uint32(g) << 8) | b;
+    }
+
+    void clear() override {
+        kernels.fill(pixels.data(), width * height, color);
+    }
+
+    void drawPoints(const SDL_Point* points, int count) override {
+        for (int i = 0; i < count; i++)
+            plot(points[i].x, points[i].y);
+    }
+
+    void drawLine(int x1, int y1, int x2, int y2) override {
+        if (y1 == y2) {
+            hline(min(x1, x2), max(x1, x2), y1);
+            return;
+        }
+        int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+        int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+        int err = dx + dy;
+        while (true) {
+            plot(x1, y1);
+            if (x1 == x2 && y1 == y2)
+                break;
+            int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x1 += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y1 += sy;
+            }
+        }
+    }
+
+    void fillRect(const SDL_Rect& rect) override {
+        SDL_Rect r;
+        if (!clip(rect, r))
+            return;
+        for (int y = r.y; y < r.y + r.h; y++)
+            kernels.fill(&pixels[y * width + r.x], r.w, color);
+    }
+
+    void drawRect(const SDL_Rect& rect) override {
+        if (rect.w <= 0 || rect.h <= 0)
+            return;
+        int right = rect.x + rect.w - 1;
+        int bottom = rect.y + rect.h - 1;
+        hline(rect.x, right, rect.y);
+        hline(rect.x, right, bottom);
+        for (int y = rect.y + 1; y < bottom; y++) {
+            plot(rect.x, y);
+            plot(right, y);
+        }
+    }
+
+    unique_ptr<CanvasImage> createImage(SDL_Surface* surface) override {
+        auto image = make_unique<PixelImage>();
+        if (!readPixels(surface, *image, image->pixels))
+            return nullptr;
+        for (Uint32& p : image->pixels)
+            p |= 0xFF000000u;
+        return image;
+    }
+
+    unique_ptr<CanvasImage> createGlyph(SDL_Surface* surface) override {
+        auto glyph = make_unique<MaskImage>();
+        vector<Uint32> argb;
+        if (!readPixels(surface, *glyph, argb))
+            return nullptr;
+        glyph->coverage.resize(argb.size());
+        for (size_t i = 0; i < argb.size(); i++)
+            glyph->coverage[i] = static_cast<Uint8>(argb[i] >> 24);
+        return glyph;
+    }
+
+    void drawImage(const CanvasImage& image, int x, int y) override {
+        const PixelImage& src = static_cast<const PixelImage&>(image);
+        SDL_Rect r;
+        if (!clip({x, y, src.w, src.h}, r))
+            return;
+        for (int row = r.y; row < r.y + r.h; row++)
+            kernels.copy(&pixels[row * width + r.x], &src.pixels[(row - y) * src.w + (r.x - x)], r.w);
+    }
+
+    void drawGlyph(const CanvasImage& glyph, int x, int y, SDL_Color c) override {
+        const MaskImage& src = static_cast<const MaskImage&>(glyph);
+        SDL_Rect r;
+        if (c.a == 0 || !clip({x, y, src.w, src.h}, r))
+            return;
+        Uint32 tint = 0xFF000000u | (Uint32(c.r) << 16) | (Uint32(c.g) << 8) | c.b;
+        for (int row = r.y; row < r.y + r.h; row++) {
+            const Uint8* coverage = &src.coverage[(row - y) * src.w + (r.x - x)];
+            if (c.a != 255) {
+                scaled.resize(r.w);
+                for (int i = 0; i < r.w; i++)
+                    scaled[i] = static_cast<Uint8>((coverage[i] * c.a + 127) / 255);
+                coverage = scaled.data();
+            }
+            kernels.blend(&pixels[row * width + r.x], coverage, r.w, tint);
+        }
+    }
+
+    // Diffs the frame against what was last shown in bands of BAND rows and
+    // copies only the changed part of each band to the window, or all of it
+    // after invalidate().
+    void present() override {
+        const int BAND = 16;
+        SDL_Surface* target = window ? SDL_GetWindowSurface(window) : nullptr;
+        bool full = repaint || target != lastTarget;
+        repaint = false;
+        lastTarget = target;
+
+        dirty.clear();
+        for (int y0 = 0; y0 < height; y0 += BAND) {
+            int y1 = min(y0 + BAND, height);
+            int left = width, right = -1;
+            for (int y = y0; y < y1; y++) {
+                const Uint32* now = &pixels[y * width];
+                const Uint32* was = &shown[y * width];
+                if (full) {
+                    left = 0;
+                    right = width - 1;
+                    break;
+                }
+                if (memcmp(now, was, width * sizeof(Uint32)) == 0)
+                    continue;
+                int l = 0;
+                while (now[l] == was[l])
+                    l++;
+                int r = width - 1;
+                while (now[r] == was[r])
+                    r--;
+                left = min(left, l);
+                right = max(right, r);
+            }
+            if (right < 0)
+                continue;
+            SDL_Rect rect = {left, y0, right - left + 1, y1 - y0};
+            for (int y = y0; y < y1; y++)
+                kernels.copy(&shown[y * width + left], &pixels[y * width + left], rect.w);
+            dirty.push_back(rect);
+        }
+
+        if (!target || !frame || dirty.empty())
+            return;
+        for (const SDL_Rect& rect : dirty) {
+            SDL_Rect src = rect;
+            SDL_Rect dst = rect;
+            SDL_BlitSurface(frame, &src, target, &dst);
+        }
+        SDL_UpdateWindowSurfaceRects(window, dirty.data(), static_cast<int>(dirty.size()));
+    }
+
+    void invalidate() override {
+        repaint = true;
+    }
+
+private:
+    struct PixelImage : CanvasImage {
+        vector<Uint32> pixels;
+    };
+
+    struct MaskImage : CanvasImage {
+        vector<Uint8> coverage;
+    };
+
+    bool readPixels(SDL_Surface* surface, CanvasImage& image, vector<Uint32>& out) {
+        SDL_Surface* argb = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        if (!argb)
+            return false;
+        SDL_LockSurface(argb);
+        image.w = argb->w;
+        image.h = argb->h;
+        out.resize(argb->w * argb->h);
+        for (int y = 0; y < argb->h; y++)
+            memcpy(&out[y * argb->w], static_cast<Uint8*>(argb->pixels) + y * argb->pitch, argb->w * sizeof(Uint32));
+        SDL_UnlockSurface(argb);
+        SDL_FreeSurface(argb);
+        return true;
+    }
+
+    bool clip(const SDL_Rect& rect, SDL_Rect& out) const {
+        int x0 = max(rect.x, 0);
+        int y0 = max(rect.y, 0);
+        int x1 = min(rect.x + rect.w, width);
+        int y1 = min(rect.y + rect.h, height);
+        if (x0 >= x1 || y0 >= y1)
+            return false;
+        out = {x0, y0, x1 - x0, y1 - y0};
+        return true;
+    }
+
+    void plot(int x, int y) {
+        if (x >= 0 && x < width && y >= 0 && y < height)
+            pixels[y * width + x] = color;
+    }
+
+    void hline(int x1, int x2, int y) {
+        SDL_Rect r;
+        if (clip({x1, y, x2 - x1 + 1, 1}, r))
+            kernels.fill(&pixels[r.y * width + r.x], r.w, color);
+    }
+
+    SDL_Window* window;
+    int width;
+    int height;
+    vector<Uint32> pixels;
+    vector<Uint32> shown;
+    vector<Uint8> scaled;
+    vector<SDL_Rect> dirty;
+    Kernels kernels;
+    Uint32 color = 0xFF000000u;
+    SDL_Surface* frame = nullptr;
+    SDL_Surface* lastTarget = nullptr;
+    bool repaint = false;
+};
+
+unique_ptr<Canvas> createSoftwareCanvas(SDL_Window* window, int width, int height, SimdLevel level) {
+    return make_unique<SoftwareCanvas>(window, width, height, level);
+}
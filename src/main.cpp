@@ -6,11 +6,30 @@
 #include <algorithm>
 #include <ctime>
 #include <cstdlib>
-#include <set>
 #include <SDL_ttf.h>
 #include <fstream>
 #include <sstream>
 #include <SDL_image.h>
+#include "canvas.h"
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cctype>
+#include <bitset>
+#include <unordered_map>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// SDL_ttf 2.0.18 added the 32-bit glyph lookups; older versions only cover
+// the Basic Multilingual Plane.
+#if defined(SDL_TTF_VERSION_ATLEAST)
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 18)
+#define HAVE_TTF_GLYPH32 1
+#endif
+#endif
 
 using namespace std;
 
@@ -59,36 +78,507 @@ void updateHighScores(int streak) {
     saveHighScores(highScores);
 }
 
-void SDL_RenderDrawEllipse(SDL_Renderer *renderer, int x0, int y0, int rx, int ry);
+const int MAX_LETTERS = 64;
+
+u32string decodeUtf8(const string& text) {
+    u32string out;
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        int extra = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+        if (extra < 0 || i + extra >= text.size()) {
+            out += U'\uFFFD';
+            i++;
+            continue;
+        }
+        char32_t cp = extra == 0 ? c : c & (0x3F >> extra);
+        bool valid = true;
+        for (int k = 1; k <= extra; k++) {
+            unsigned char cc = static_cast<unsigned char>(text[i + k]);
+            if ((cc & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        if (!valid) {
+            out += U'\uFFFD';
+            i++;
+            continue;
+        }
+        out += cp;
+        i += extra + 1;
+    }
+    return out;
+}
+
+string encodeUtf8(char32_t cp) {
+    string out;
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// A language's guessable letters. Every case and tone variant of a letter maps
+// to the same index, so guessing "a" also reveals "á", "ả", ... and the
+// per-round letter state fits in a bitset<MAX_LETTERS>.
+struct Alphabet {
+    string name;
+    vector<string> letters;
+    unordered_map<char32_t, int> index;
+    unordered_map<char32_t, char32_t> lower;
+    unordered_map<char32_t, u32string> tones;
+};
+
+vector<pair<string, string>> latinRows(const string& skip = "") {
+    vector<pair<string, string>> rows;
+    for (char c = 'a'; c <= 'z'; c++) {
+        if (skip.find(c) == string::npos)
+            rows.push_back({string(1, c), string(1, static_cast<char>(toupper(c)))});
+    }
+    return rows;
+}
+
+// Each row is {lowercase forms, uppercase forms}; the first form is the base
+// letter, the rest are its tone variants in the order none, grave, acute,
+// hook above, tilde, dot below.
+Alphabet makeAlphabet(const string& name, const vector<pair<string, string>>& rows) {
+    Alphabet alphabet;
+    alphabet.name = name;
+    for (const auto& row : rows) {
+        u32string lo = decodeUtf8(row.first);
+        u32string up = decodeUtf8(row.second);
+        int idx = static_cast<int>(alphabet.letters.size());
+        alphabet.letters.push_back(encodeUtf8(lo[0]));
+        for (size_t i = 0; i < lo.size(); i++) {
+            alphabet.index[lo[i]] = idx;
+            alphabet.index[up[i]] = idx;
+            alphabet.lower[lo[i]] = lo[i];
+            alphabet.lower[up[i]] = lo[i];
+        }
+        if (lo.size() > 1)
+            alphabet.tones[lo[0]] = lo;
+    }
+    // Letter state is a bitset<MAX_LETTERS>; a larger alphabet would throw
+    // out_of_range mid-round, so refuse it here.
+    if (alphabet.letters.size() > MAX_LETTERS) {
+        cerr << "Alphabet " << name << " has " << alphabet.letters.size() << " letters, more than "
+             << MAX_LETTERS << "; using English instead" << endl;
+        return makeAlphabet("en", latinRows());
+    }
+    return alphabet;
+}
+
+const Alphabet& englishAlphabet() {
+    static const Alphabet alphabet = makeAlphabet("en", latinRows());
+    return alphabet;
+}
+
+const Alphabet& vietnameseAlphabet() {
+    static const Alphabet alphabet = [] {
+        vector<pair<string, string>> rows = {
+            {"aàáảãạ", "AÀÁẢÃẠ"}, {"ăằắẳẵặ", "ĂẰẮẲẴẶ"}, {"âầấẩẫậ", "ÂẦẤẨẪẬ"},
+            {"đ", "Đ"},
+            {"eèéẻẽẹ", "EÈÉẺẼẸ"}, {"êềếểễệ", "ÊỀẾỂỄỆ"},
+            {"iìíỉĩị", "IÌÍỈĨỊ"},
+            {"oòóỏõọ", "OÒÓỎÕỌ"}, {"ôồốổỗộ", "ÔỒỐỔỖỘ"}, {"ơờớởỡợ", "ƠỜỚỞỠỢ"},
+            {"uùúủũụ", "UÙÚỦŨỤ"}, {"ưừứửữự", "ƯỪỨỬỮỰ"},
+            {"yỳýỷỹỵ", "YỲÝỶỸỴ"},
+        };
+        // Consonants, plus f/j/w/z for loanwords.
+        for (const auto& row : latinRows("aeiouy"))
+            rows.push_back(row);
+        return makeAlphabet("vi", rows);
+    }();
+    return alphabet;
+}
+
+const Alphabet* findAlphabet(const string& name) {
+    if (name == "en")
+        return &englishAlphabet();
+    if (name == "vi")
+        return &vietnameseAlphabet();
+    return nullptr;
+}
+
+int letterIndex(const Alphabet& alphabet, char32_t cp) {
+    auto it = alphabet.index.find(cp);
+    return it == alphabet.index.end() ? -1 : it->second;
+}
 
-void drawHangman(SDL_Renderer *renderer, int wrongGuesses)
+// Lowercases a word and composes decomposed (NFD) diacritics into the
+// precomposed forms the alphabet knows. Returns false if any character is not
+// a letter of the alphabet.
+bool normalizeWord(const string& text, const Alphabet& alphabet, string& out) {
+    static const unordered_map<char32_t, int> toneMarks = {
+        {0x300, 1}, {0x301, 2}, {0x309, 3}, {0x303, 4}, {0x323, 5},
+    };
+    static const vector<pair<u32string, char32_t>> modifierMarks = {
+        {U"a\u0306", U'ă'}, {U"a\u0302", U'â'}, {U"e\u0302", U'ê'},
+        {U"o\u0302", U'ô'}, {U"o\u031B", U'ơ'}, {U"u\u031B", U'ư'},
+    };
+
+    u32string cps = decodeUtf8(text);
+    size_t begin = cps.find_first_not_of(U" \t\r");
+    size_t end = cps.find_last_not_of(U" \t\r");
+    out.clear();
+    if (begin == u32string::npos)
+        return false;
+
+    for (size_t i = begin; i <= end; i++) {
+        if (cps[i] == U' ') {
+            if (out.back() != ' ')
+                out += ' ';
+            continue;
+        }
+        auto lower = alphabet.lower.find(cps[i]);
+        if (lower == alphabet.lower.end())
+            return false;
+        char32_t letter = lower->second;
+        int tone = 0;
+        while (i + 1 <= end && cps[i + 1] >= 0x300 && cps[i + 1] <= 0x36F) {
+            char32_t mark = cps[++i];
+            auto t = toneMarks.find(mark);
+            if (t != toneMarks.end() && tone == 0) {
+                tone = t->second;
+                continue;
+            }
+            auto m = find_if(modifierMarks.begin(), modifierMarks.end(), [&](const pair<u32string, char32_t>& p) {
+                return p.first[0] == letter && p.first[1] == mark;
+            });
+            if (m == modifierMarks.end())
+                return false;
+            letter = m->second;
+        }
+        if (tone) {
+            auto forms = alphabet.tones.find(letter);
+            if (forms == alphabet.tones.end())
+                return false;
+            letter = forms->second[tone];
+        }
+        if (letterIndex(alphabet, letter) < 0)
+            return false;
+        out += encodeUtf8(letter);
+    }
+    return true;
+}
+
+// A word split into one display glyph per character, with the alphabet index
+// each one is revealed by (-1 for spaces, which are always shown).
+struct EncodedWord {
+    vector<string> glyphs;
+    vector<int> letters;
+    bitset<MAX_LETTERS> mask;
+};
+
+EncodedWord encodeWord(const string& word, const Alphabet& alphabet) {
+    EncodedWord encoded;
+    for (char32_t cp : decodeUtf8(word)) {
+        int idx = letterIndex(alphabet, cp);
+        encoded.glyphs.push_back(encodeUtf8(cp));
+        encoded.letters.push_back(idx);
+        if (idx >= 0)
+            encoded.mask.set(idx);
+    }
+    return encoded;
+}
+
+// Immutable word list snapshot. The watcher thread builds a new one and swaps
+// it in; readers take their own reference, so a round keeps its word.
+struct WordList {
+    const Alphabet* alphabet = &englishAlphabet();
+    vector<string> words;
+};
+
+// One word per line. A "# language: vi" line before the first word selects
+// the alphabet; other lines starting with '#' are comments. Non-blank lines
+// that are not words of the alphabet are counted in rejected.
+shared_ptr<const WordList> parseWordList(const string& path, int& rejected) {
+    rejected = 0;
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    auto list = make_shared<WordList>();
+    string line;
+    string w;
+    bool firstLine = true;
+    while (getline(file, line)) {
+        // Editors such as Notepad start UTF-8 files with a byte-order mark.
+        if (firstLine && line.compare(0, 3, "\xEF\xBB\xBF") == 0)
+            line.erase(0, 3);
+        firstLine = false;
+        if (!line.empty() && line[0] == '#') {
+            istringstream iss(line.substr(1));
+            string key, value;
+            iss >> key >> value;
+            if (key == "language:" && !value.empty() && list->words.empty()) {
+                const Alphabet* alphabet = findAlphabet(value);
+                if (alphabet)
+                    list->alphabet = alphabet;
+                else
+                    cerr << "Unknown word list language: " << value << endl;
+            } else if (key.compare(0, 8, "language") == 0) {
+                cerr << "Ignoring word list directive in " << path << ": \"" << line
+                     << "\" (expected \"# language: <code>\" before the first word)" << endl;
+            }
+            continue;
+        }
+        if (line.find_first_not_of(" \t\r") == string::npos)
+            continue;
+        if (normalizeWord(line, *list->alphabet, w))
+            list->words.push_back(w);
+        else
+            rejected++;
+    }
+    sort(list->words.begin(), list->words.end());
+    list->words.erase(unique(list->words.begin(), list->words.end()), list->words.end());
+    if (list->words.empty()) {
+        return nullptr;
+    }
+    return list;
+}
+
+// The word being guessed, with the alphabet of the list it came from.
+struct Round {
+    string word;
+    const Alphabet* alphabet;
+    EncodedWord encoded;
+};
+
+Round pickRound(const shared_ptr<const WordList>& list, const string& avoid = "") {
+    const vector<string>& words = list->words;
+    Round round;
+    round.alphabet = list->alphabet;
+    if (words.size() == 1) {
+        round.word = words[0];
+    } else {
+        do {
+            round.word = words[rand() % words.size()];
+        } while (round.word == avoid);
+    }
+    round.encoded = encodeWord(round.word, *round.alphabet);
+    return round;
+}
+
+// Loads the dictionary file on a background thread and reloads it whenever it
+// changes on disk. The render loop only ever does an atomic_load.
+class WordListWatcher {
+public:
+    WordListWatcher(const string& path, shared_ptr<const WordList> fallback)
+        : path(path), live(move(fallback)), running(true) {
+        worker = thread(&WordListWatcher::run, this);
+    }
+
+    ~WordListWatcher() {
+        running = false;
+        worker.join();
+    }
+
+    shared_ptr<const WordList> current() const {
+        return atomic_load(&live);
+    }
+
+private:
+    void reload() {
+        int rejected = 0;
+        shared_ptr<const WordList> next = parseWordList(path, rejected);
+        if (!next) {
+            cerr << "No usable words in " << path << " (" << rejected
+                 << " lines rejected), keeping the current word list" << endl;
+            return;
+        }
+        if (rejected > 0) {
+            cerr << "Skipped " << rejected << " lines in " << path << " that are not "
+                 << next->alphabet->name << " words" << endl;
+        }
+        atomic_store(&live, next);
+        cout << "Loaded " << next->words.size() << " words from " << path << endl;
+    }
+
+    void run() {
+        reload();
+#ifdef __linux__
+        // Watch the directory rather than the file so editors that save by
+        // rename, and rotation scripts that replace the file, are picked up.
+        size_t slash = path.find_last_of('/');
+        string dir = slash == string::npos ? "." : path.substr(0, slash);
+        string name = slash == string::npos ? path : path.substr(slash + 1);
+
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            cerr << "inotify unavailable, word list hot reload disabled" << endl;
+            return;
+        }
+        if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            cerr << "Could not watch " << dir << ", word list hot reload disabled" << endl;
+            close(fd);
+            return;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        while (running) {
+            pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 250) <= 0)
+                continue;
+            bool changed = false;
+            ssize_t len;
+            while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + len; ) {
+                    const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                    if ((ev->mask & IN_Q_OVERFLOW) || (ev->len > 0 && name == ev->name))
+                        changed = true;
+                    p += sizeof(inotify_event) + ev->len;
+                }
+            }
+            if (changed)
+                reload();
+        }
+        close(fd);
+#endif
+    }
+
+    string path;
+    shared_ptr<const WordList> live;
+    atomic<bool> running;
+    thread worker;
+};
+
+// Rasterizes each code point of a font once, on first use, and draws text by
+// copying the cached glyphs. Glyphs are rendered white and tinted when drawn,
+// so one cache serves every text color. The pen advances by the font's glyph
+// metrics and pair kerning, matching a whole-string TTF render.
+class GlyphCache {
+public:
+    GlyphCache(Canvas& canvas, TTF_Font* font) : canvas(canvas), font(font) {}
+
+    void clear() {
+        glyphs.clear();
+    }
+
+    int measure(const string& text) {
+        int w = 0;
+        char32_t prev = 0;
+        for (char32_t cp : decodeUtf8(text)) {
+            w += kerning(prev, cp) + glyph(cp).advance;
+            prev = cp;
+        }
+        return w;
+    }
+
+    void draw(const string& text, int x, int y, SDL_Color color) {
+        char32_t prev = 0;
+        for (char32_t cp : decodeUtf8(text)) {
+            const Glyph& g = glyph(cp);
+            x += kerning(prev, cp);
+            if (g.image)
+                canvas.drawGlyph(*g.image, x + g.offset, y, color);
+            x += g.advance;
+            prev = cp;
+        }
+    }
+
+    void drawCentered(const string& text, int y, SDL_Color color) {
+        draw(text, (WINDOW_WIDTH - measure(text)) / 2, y, color);
+    }
+
+private:
+    struct Glyph {
+        unique_ptr<CanvasImage> image;
+        int advance = 0;
+        int offset = 0;
+    };
+
+    int kerning(char32_t prev, char32_t cp) {
+        if (!prev)
+            return 0;
+#ifdef HAVE_TTF_GLYPH32
+        return TTF_GetFontKerningSizeGlyphs32(font, prev, cp);
+#else
+        if (prev > 0xFFFF || cp > 0xFFFF)
+            return 0;
+        return TTF_GetFontKerningSizeGlyphs(font, static_cast<Uint16>(prev), static_cast<Uint16>(cp));
+#endif
+    }
+
+    const Glyph& glyph(char32_t cp) {
+        auto it = glyphs.find(cp);
+        if (it != glyphs.end())
+            return it->second;
+
+        Glyph g;
+        int minx = 0, maxx = 0, miny = 0, maxy = 0, advance = 0;
+#ifdef HAVE_TTF_GLYPH32
+        int metrics = TTF_GlyphMetrics32(font, cp, &minx, &maxx, &miny, &maxy, &advance);
+#else
+        int metrics = cp <= 0xFFFF ? TTF_GlyphMetrics(font, static_cast<Uint16>(cp), &minx, &maxx, &miny, &maxy, &advance) : -1;
+#endif
+
+        SDL_Color white = {255, 255, 255, 255};
+        SDL_Surface* surface = TTF_RenderUTF8_Blended(font, encodeUtf8(cp).c_str(), white);
+        if (surface) {
+            // A single-glyph render starts at the pen position, or at minx
+            // when the glyph overhangs to the left.
+            g.advance = metrics == 0 ? advance : surface->w;
+            g.offset = metrics == 0 ? min(minx, 0) : 0;
+            if (cp != U' ')
+                g.image = canvas.createGlyph(surface);
+            SDL_FreeSurface(surface);
+        }
+        return glyphs.emplace(cp, move(g)).first->second;
+    }
+
+    Canvas& canvas;
+    TTF_Font* font;
+    unordered_map<char32_t, Glyph> glyphs;
+};
+
+void drawEllipse(Canvas& canvas, int x0, int y0, int rx, int ry);
+
+void drawHangman(Canvas& canvas, int wrongGuesses)
 {
-    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-    SDL_RenderDrawLine(renderer, 100, 500, 300, 500); 
-    SDL_RenderDrawLine(renderer, 200, 500, 200, 100); 
-    SDL_RenderDrawLine(renderer, 200, 100, 350, 100); 
-    SDL_RenderDrawLine(renderer, 350, 100, 350, 150); 
+    canvas.setDrawColor(200, 200, 200, 255);
+    canvas.drawLine(100, 500, 300, 500); 
+    canvas.drawLine(200, 500, 200, 100); 
+    canvas.drawLine(200, 100, 350, 100); 
+    canvas.drawLine(350, 100, 350, 150); 
 
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    canvas.setDrawColor(255, 255, 255, 255);
     if (wrongGuesses > 0)
     {
         SDL_Rect head = {325, 150, 50, 50};
-        SDL_RenderDrawEllipse(renderer, head.x + 25, head.y + 25, 25, 25);
+        drawEllipse(canvas, head.x + 25, head.y + 25, 25, 25);
     }
     if (wrongGuesses > 1)
-        SDL_RenderDrawLine(renderer, 350, 200, 350, 320);
+        canvas.drawLine(350, 200, 350, 320);
     if (wrongGuesses > 2)
-        SDL_RenderDrawLine(renderer, 350, 220, 310, 270);
+        canvas.drawLine(350, 220, 310, 270);
     if (wrongGuesses > 3)
-        SDL_RenderDrawLine(renderer, 350, 220, 390, 270);
+        canvas.drawLine(350, 220, 390, 270);
     if (wrongGuesses > 4)
-        SDL_RenderDrawLine(renderer, 350, 320, 310, 380);
+        canvas.drawLine(350, 320, 310, 380);
     if (wrongGuesses > 5)
-        SDL_RenderDrawLine(renderer, 350, 320, 390, 380);
+        canvas.drawLine(350, 320, 390, 380);
 }
 
-void SDL_RenderDrawEllipse(SDL_Renderer *renderer, int x0, int y0, int rx, int ry)
+// Collects the outline points and submits them in one batch instead of one
+// draw call per point.
+void drawEllipse(Canvas& canvas, int x0, int y0, int rx, int ry)
 {
+    vector<SDL_Point> points;
     int x, y;
     int rx2 = rx * rx;
     int ry2 = ry * ry;
@@ -102,10 +592,10 @@ void SDL_RenderDrawEllipse(SDL_Renderer *renderer, int x0, int y0, int rx, int r
     y = ry;
     while (px < py)
     {
-        SDL_RenderDrawPoint(renderer, x0 + x, y0 + y);
-        SDL_RenderDrawPoint(renderer, x0 - x, y0 + y);
-        SDL_RenderDrawPoint(renderer, x0 + x, y0 - y);
-        SDL_RenderDrawPoint(renderer, x0 - x, y0 - y);
+        points.push_back({x0 + x, y0 + y});
+        points.push_back({x0 - x, y0 + y});
+        points.push_back({x0 + x, y0 - y});
+        points.push_back({x0 - x, y0 - y});
         x++;
         px += twory2;
         if (p < 0)
@@ -123,10 +613,10 @@ void SDL_RenderDrawEllipse(SDL_Renderer *renderer, int x0, int y0, int rx, int r
     p = round(ry2 * (x + 0.5) * (x + 0.5) + rx2 * (y - 1) * (y - 1) - rx2 * ry2);
     while (y >= 0)
     {
-        SDL_RenderDrawPoint(renderer, x0 + x, y0 + y);
-        SDL_RenderDrawPoint(renderer, x0 - x, y0 + y);
-        SDL_RenderDrawPoint(renderer, x0 + x, y0 - y);
-        SDL_RenderDrawPoint(renderer, x0 - x, y0 - y);
+        points.push_back({x0 + x, y0 + y});
+        points.push_back({x0 - x, y0 + y});
+        points.push_back({x0 + x, y0 - y});
+        points.push_back({x0 - x, y0 - y});
         y--;
         py -= tworx2;
         if (p > 0)
@@ -140,13 +630,296 @@ void SDL_RenderDrawEllipse(SDL_Renderer *renderer, int x0, int y0, int rx, int r
             p += rx2 - py + px;
         }
     }
+    canvas.drawPoints(points.data(), static_cast<int>(points.size()));
+}
+
+// The window contents may have been lost (covered, minimized or hidden), so
+// the next present has to repaint all of it.
+bool isRepaintEvent(const SDL_Event& e)
+{
+    return e.type == SDL_WINDOWEVENT &&
+           (e.window.event == SDL_WINDOWEVENT_EXPOSED || e.window.event == SDL_WINDOWEVENT_SHOWN ||
+            e.window.event == SDL_WINDOWEVENT_RESTORED);
+}
+
+// Scales an image to the window once so drawing it each frame is a plain copy.
+SDL_Surface* scaleToWindow(SDL_Surface* surface)
+{
+    SDL_Surface* scaled = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (scaled)
+    {
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        SDL_BlitScaled(surface, NULL, scaled, NULL);
+    }
+    return scaled;
+}
+
+void drawStartScreen(Canvas& canvas, const CanvasImage& background, GlyphCache& fontGlyphs, GlyphCache& largeGlyphs,
+                     GlyphCache& hugeGlyphs, GlyphCache& mediumGlyphs, const vector<HighScore>& highScores,
+                     bool isHovering, int maxWrong)
+{
+    canvas.setDrawColor(0, 0, 50, 255);
+    canvas.clear();
+
+    // Draw background
+    canvas.drawImage(background, 0, 0);
+
+    SDL_Color titleColor = {0, 0, 0, 255};
+    string titleText = "HANGMAN";
+    hugeGlyphs.drawCentered(titleText, 50, titleColor);
+
+    if (!highScores.empty()) {
+        string highScoreText = "HIGHEST STREAK: " + to_string(highScores[0].streak);
+        mediumGlyphs.drawCentered(highScoreText, 250, titleColor);
+    }
+
+    SDL_Rect buttonRect = {
+        (WINDOW_WIDTH - 300) / 2,
+        WINDOW_HEIGHT - 150,
+        300,
+        100
+    };
+    canvas.setDrawColor(isHovering ? 0 : 0, isHovering ? 200 : 150, 0, 255);
+    canvas.fillRect(buttonRect);
+    canvas.setDrawColor(255, 255, 255, 255);
+    canvas.drawRect(buttonRect);
+
+    string startText = "START GAME";
+    largeGlyphs.drawCentered(startText, WINDOW_HEIGHT - 130, titleColor);
+
+    SDL_Color instructColor = {180, 180, 180, 255};
+    string instructText = "Click START GAME to begin";
+    fontGlyphs.drawCentered(instructText, WINDOW_HEIGHT - 50, instructColor);
+
+    string wrongGuessText = "Wrong guesses allowed: " + to_string(maxWrong);
+    fontGlyphs.draw(wrongGuessText, 20, 20, titleColor);
+
+    canvas.present();
+}
+
+void drawGameScreen(Canvas& canvas, GlyphCache& fontGlyphs, GlyphCache& largeGlyphs, const string& displayWord,
+                    const string& guessedLetters, int wrongGuesses, int maxWrong)
+{
+    // Draw game screen
+    canvas.setDrawColor(0, 128, 0, 255);
+    canvas.clear();
+    drawHangman(canvas, wrongGuesses);
+
+    // Render word with larger font
+    SDL_Color wordColor = {0, 0, 0, 255};
+    largeGlyphs.drawCentered(displayWord, WINDOW_HEIGHT - 150, wordColor);
+
+    // Render guessed letters with blue color
+    SDL_Color guessedColor = {100, 180, 255, 255};
+    fontGlyphs.draw("Letters tried: " + guessedLetters, 50, 50, guessedColor);
+
+    SDL_Color wrongColor;
+    if (wrongGuesses <= 2) {
+        wrongColor = {100, 255, 100, 255};
+    } else if (wrongGuesses <= 4) {
+        wrongColor = {255, 255, 100, 255};
+    } else {
+        wrongColor = {255, 100, 100, 255};
+    }
+    string wrongGuessText = "Wrong guesses: " + to_string(wrongGuesses) + "/" + to_string(maxWrong);
+    fontGlyphs.draw(wrongGuessText, 20, 20, wrongColor);
+
+    canvas.present();
+}
+
+void drawGameOverScreen(Canvas& canvas, GlyphCache& hugeGlyphs, GlyphCache& mediumGlyphs, int currentStreak, int totalScore,
+                        const string& word, const SDL_Rect& mainMenuButton, const SDL_Rect& playAgainButton)
+{
+    canvas.setDrawColor(100, 0, 0, 255);
+    canvas.clear();
+    SDL_Color gameOverColor = {255, 255, 255, 255};
+    string gameOverText = "Game Over!";
+    hugeGlyphs.drawCentered(gameOverText, WINDOW_HEIGHT / 2 - 150, gameOverColor);
+
+    // Display final stats
+    string statsText = "Words Guessed: " + to_string(currentStreak) +
+                       " | Final Score: " + to_string(totalScore);
+    mediumGlyphs.drawCentered(statsText, WINDOW_HEIGHT / 2 - 50, gameOverColor);
+    string wordText = "The word was: " + word;
+    mediumGlyphs.drawCentered(wordText, WINDOW_HEIGHT / 2 + 50, gameOverColor);
+
+    int mouseX = 0, mouseY = 0;
+    SDL_GetMouseState(&mouseX, &mouseY);
+    bool isHoveringMainMenu = (mouseX >= mainMenuButton.x && mouseX <= mainMenuButton.x + mainMenuButton.w &&
+                             mouseY >= mainMenuButton.y && mouseY <= mainMenuButton.y + mainMenuButton.h);
+    bool isHoveringPlayAgain = (mouseX >= playAgainButton.x && mouseX <= playAgainButton.x + playAgainButton.w &&
+                              mouseY >= playAgainButton.y && mouseY <= playAgainButton.y + playAgainButton.h);
+
+    canvas.setDrawColor(isHoveringMainMenu ? 0 : 0, isHoveringMainMenu ? 200 : 150, 0, 255);
+    canvas.fillRect(mainMenuButton);
+    canvas.setDrawColor(255, 255, 255, 255);
+    canvas.drawRect(mainMenuButton);
+
+    canvas.setDrawColor(isHoveringPlayAgain ? 0 : 0, isHoveringPlayAgain ? 200 : 150, 0, 255);
+    canvas.fillRect(playAgainButton);
+    canvas.setDrawColor(255, 255, 255, 255);
+    canvas.drawRect(playAgainButton);
+
+    string mainMenuText = "MAIN MENU";
+    mediumGlyphs.drawCentered(mainMenuText, WINDOW_HEIGHT - 180, gameOverColor);
+
+    string playAgainText = "PLAY AGAIN";
+    mediumGlyphs.drawCentered(playAgainText, WINDOW_HEIGHT - 80, gameOverColor);
+
+    canvas.present();
+}
+
+// Headless comparison of SDL's software renderer and the CPU canvas: both
+// compose the start and game screens into an off-screen 800x600 frame.
+int runRenderBenchmark(int frames)
+{
+    if (SDL_Init(0) < 0)
+    {
+        cerr << "Benchmark could not initialize SDL! SDL_Error: " << SDL_GetError() << endl;
+        return 1;
+    }
+    if (TTF_Init() < 0)
+    {
+        cerr << "Benchmark could not initialize TTF! TTF_Error: " << TTF_GetError() << endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    char* basePath = SDL_GetBasePath();
+    string fontPath = string(basePath ? basePath : "") + "../assets/font.ttf";
+    string backgroundPath = string(basePath ? basePath : "") + "../assets/background.jpeg";
+    SDL_free(basePath);
+    TTF_Font *font = TTF_OpenFont(fontPath.c_str(), 24);
+    TTF_Font *largeFont = TTF_OpenFont(fontPath.c_str(), 48);
+    TTF_Font *hugeFont = TTF_OpenFont(fontPath.c_str(), 64);
+    TTF_Font *mediumFont = TTF_OpenFont(fontPath.c_str(), 36);
+    SDL_Surface* backgroundSurface = IMG_Load(backgroundPath.c_str());
+    SDL_Surface* scaledBackground = backgroundSurface ? scaleToWindow(backgroundSurface) : nullptr;
+    SDL_FreeSurface(backgroundSurface);
+    if (!font || !largeFont || !hugeFont || !mediumFont || !scaledBackground)
+    {
+        cerr << "Benchmark could not load assets! SDL_Error: " << SDL_GetError() << endl;
+        SDL_FreeSurface(scaledBackground);
+        for (TTF_Font* f : {font, largeFont, hugeFont, mediumFont})
+        {
+            if (f)
+                TTF_CloseFont(f);
+        }
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    vector<HighScore> highScores = {{7}};
+    const int maxWrong = 6;
+    const char* backends[] = {"sdl-software", "cpu-scalar", "cpu-sse2", "cpu-avx2"};
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2};
+
+    cout << "Composing " << frames << " frames per screen at " << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << endl;
+    for (int b = 0; b < 4; b++)
+    {
+        bool sdl = b == 0;
+        if (!sdl && !simdLevelSupported(levels[b]))
+        {
+            cout << backends[b] << ": not supported on this CPU" << endl;
+            continue;
+        }
+
+        SDL_Surface* target = nullptr;
+        SDL_Renderer* renderer = nullptr;
+        unique_ptr<Canvas> canvas;
+        if (sdl)
+        {
+            target = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+            renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+            if (!renderer)
+            {
+                cerr << backends[b] << ": could not create renderer! SDL_Error: " << SDL_GetError() << endl;
+                SDL_FreeSurface(target);
+                continue;
+            }
+            canvas = createRendererCanvas(renderer);
+        }
+        else
+        {
+            canvas = createSoftwareCanvas(nullptr, WINDOW_WIDTH, WINDOW_HEIGHT, levels[b]);
+        }
+
+        {
+            unique_ptr<CanvasImage> background = canvas->createImage(scaledBackground);
+            if (background)
+            {
+                GlyphCache fontGlyphs(*canvas, font);
+                GlyphCache largeGlyphs(*canvas, largeFont);
+                GlyphCache hugeGlyphs(*canvas, hugeFont);
+                GlyphCache mediumGlyphs(*canvas, mediumFont);
+
+                // The first frame of each screen fills the glyph caches.
+                drawStartScreen(*canvas, *background, fontGlyphs, largeGlyphs, hugeGlyphs, mediumGlyphs, highScores, false, maxWrong);
+                drawGameScreen(*canvas, fontGlyphs, largeGlyphs, "_ a _ _ m a _ ", "a m x y z ", maxWrong, maxWrong);
+
+                Uint64 start = SDL_GetPerformanceCounter();
+                for (int i = 0; i < frames; i++)
+                    drawStartScreen(*canvas, *background, fontGlyphs, largeGlyphs, hugeGlyphs, mediumGlyphs, highScores, (i / 10) % 2 == 1, maxWrong);
+                Uint64 middle = SDL_GetPerformanceCounter();
+                for (int i = 0; i < frames; i++)
+                    drawGameScreen(*canvas, fontGlyphs, largeGlyphs, "_ a _ _ m a _ ", "a m x y z ", (i / 10) % (maxWrong + 1), maxWrong);
+                Uint64 end = SDL_GetPerformanceCounter();
+
+                double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+                cout << backends[b] << ": start screen " << (middle - start) * msPerTick / frames
+                     << " ms/frame, game screen " << (end - middle) * msPerTick / frames << " ms/frame" << endl;
+            }
+            else
+            {
+                cerr << backends[b] << ": could not upload background! SDL_Error: " << SDL_GetError() << endl;
+            }
+        }
+
+        canvas.reset();
+        if (renderer)
+            SDL_DestroyRenderer(renderer);
+        if (target)
+            SDL_FreeSurface(target);
+    }
+
+    SDL_FreeSurface(scaledBackground);
+    TTF_CloseFont(font);
+    TTF_CloseFont(largeFont);
+    TTF_CloseFont(hugeFont);
+    TTF_CloseFont(mediumFont);
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
 }
+
 int main(int argc, char *argv[])
 {
+    bool cpuRender = false;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--cpu-render")
+            cpuRender = true;
+        else if (arg == "--bench-render")
+        {
+            int frames = 300;
+            if (i + 1 < argc)
+            {
+                char* end = nullptr;
+                long n = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' && n > 0)
+                    frames = static_cast<int>(min(n, 1000000L));
+            }
+            return runRenderBenchmark(frames);
+        }
+    }
+
     srand(static_cast<unsigned int>(time(nullptr)));
-    vector<string> wordList = {"computer", "hangman", "sdl", "window", "programming"};
-    string word = wordList[rand() % wordList.size()];
-    set<char> guessed;
+    auto defaultWords = make_shared<WordList>();
+    defaultWords->words = {"computer", "hangman", "sdl", "window", "programming"};
+    Round round;
+    bitset<MAX_LETTERS> guessed;
     int wrongGuesses = 0;
     const int maxWrong = 6;
     int currentStreak = 0;
@@ -205,16 +978,28 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer)
+    // Without a usable GPU, compose frames on the CPU and write them straight
+    // to the window surface instead of going through SDL's software renderer.
+    SDL_Renderer *renderer = nullptr;
+    if (!cpuRender)
     {
-        cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << endl;
-        SDL_DestroyWindow(window);
-        Mix_CloseAudio();
-        TTF_Quit();
-        SDL_Quit();
-        return 1;
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        SDL_RendererInfo rendererInfo;
+        if (renderer && SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_SOFTWARE))
+        {
+            SDL_DestroyRenderer(renderer);
+            renderer = nullptr;
+        }
+        if (!renderer)
+            cerr << "Accelerated renderer unavailable, using CPU renderer. SDL_Error: " << SDL_GetError() << endl;
     }
+    unique_ptr<Canvas> canvas = renderer ? createRendererCanvas(renderer)
+                                         : createSoftwareCanvas(window, WINDOW_WIDTH, WINDOW_HEIGHT, SimdLevel::Best);
+    cout << "Renderer: " << (renderer ? "SDL accelerated" : "CPU (" + simdLevelName(SimdLevel::Best) + ")") << endl;
+
+    string wordsPath = string(basePath) + "../assets/words.txt";
+    cout << "Word list path: " << wordsPath << endl;
+    WordListWatcher wordList(wordsPath, defaultWords);
 
     string fontPath = string(basePath) + "../assets/font.ttf";
     cout << "Font path: " << fontPath << endl;
@@ -226,7 +1011,8 @@ int main(int argc, char *argv[])
     if (!font || !largeFont || !hugeFont || !mediumFont)
     {
         cerr << "Font could not be loaded! TTF_Error: " << TTF_GetError() << endl;
-        SDL_DestroyRenderer(renderer);
+        if (renderer)
+            SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         SDL_free(basePath);
         Mix_CloseAudio();
@@ -237,6 +1023,15 @@ int main(int argc, char *argv[])
 
     SDL_free(basePath);
 
+    GlyphCache fontGlyphs(*canvas, font);
+    GlyphCache largeGlyphs(*canvas, largeFont);
+    GlyphCache hugeGlyphs(*canvas, hugeFont);
+    GlyphCache mediumGlyphs(*canvas, mediumFont);
+
+    // Letters arrive as UTF-8 SDL_TEXTINPUT events so IME-composed and
+    // accented characters work, not just SDLK_a..SDLK_z.
+    SDL_StartTextInput();
+
     // Load background image
     SDL_Surface* backgroundSurface = IMG_Load("../assets/background.jpeg");
     if (!backgroundSurface)
@@ -244,9 +1039,11 @@ int main(int argc, char *argv[])
         cerr << "Failed to load background image! SDL_image Error: " << IMG_GetError() << endl;
         return 1;
     }
-    SDL_Texture* backgroundTexture = SDL_CreateTextureFromSurface(renderer, backgroundSurface);
+    SDL_Surface* scaledBackground = scaleToWindow(backgroundSurface);
     SDL_FreeSurface(backgroundSurface);
-    if (!backgroundTexture)
+    unique_ptr<CanvasImage> background = scaledBackground ? canvas->createImage(scaledBackground) : nullptr;
+    SDL_FreeSurface(scaledBackground);
+    if (!background)
     {
         cerr << "Failed to create texture from background image! SDL Error: " << SDL_GetError() << endl;
         return 1;
@@ -268,12 +1065,11 @@ int main(int argc, char *argv[])
                 if (e.type == SDL_QUIT)
                 {
                     startScreen = false;
-                    SDL_DestroyRenderer(renderer);
-                    SDL_DestroyWindow(window);
-                    Mix_CloseAudio();
-                    TTF_Quit();
-                    SDL_Quit();
-                    return 0;
+                    quit = true;
+                }
+                else if (isRepaintEvent(e))
+                {
+                    canvas->invalidate();
                 }
                 else if (e.type == SDL_MOUSEBUTTONDOWN)
                 {
@@ -297,43 +1093,6 @@ int main(int argc, char *argv[])
                 }
             }
 
-            SDL_SetRenderDrawColor(renderer, 0, 0, 50, 255);
-            SDL_RenderClear(renderer);
-
-            // Draw background
-            SDL_RenderCopy(renderer, backgroundTexture, NULL, NULL);
-
-            SDL_GetMouseState(&mouseX, &mouseY);
-
-            SDL_Color titleColor = {0, 0, 0, 255};
-            string titleText = "HANGMAN";
-            SDL_Surface *titleSurface = TTF_RenderText_Solid(hugeFont, titleText.c_str(), titleColor);
-            SDL_Texture *titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-            SDL_Rect titleRect = {
-                (WINDOW_WIDTH - titleSurface->w) / 2,
-                50,
-                titleSurface->w,
-                titleSurface->h
-            };
-            SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
-            SDL_FreeSurface(titleSurface);
-            SDL_DestroyTexture(titleTexture);
-
-            if (!highScores.empty()) {
-                string highScoreText = "HIGHEST STREAK: " + to_string(highScores[0].streak);
-                SDL_Surface *highScoreSurface = TTF_RenderText_Solid(mediumFont, highScoreText.c_str(), titleColor);
-                SDL_Texture *highScoreTexture = SDL_CreateTextureFromSurface(renderer, highScoreSurface);
-                SDL_Rect highScoreRect = {
-                    (WINDOW_WIDTH - highScoreSurface->w) / 2,
-                    250,
-                    highScoreSurface->w,
-                    highScoreSurface->h
-                };
-                SDL_RenderCopy(renderer, highScoreTexture, NULL, &highScoreRect);
-                SDL_FreeSurface(highScoreSurface);
-                SDL_DestroyTexture(highScoreTexture);
-            }
-
             SDL_GetMouseState(&mouseX, &mouseY);
             SDL_Rect buttonRect = {
                 (WINDOW_WIDTH - 300) / 2,
@@ -344,59 +1103,14 @@ int main(int argc, char *argv[])
             bool isHovering = (mouseX >= buttonRect.x && mouseX <= buttonRect.x + buttonRect.w &&
                              mouseY >= buttonRect.y && mouseY <= buttonRect.y + buttonRect.h);
 
-            SDL_SetRenderDrawColor(renderer, isHovering ? 0 : 0, isHovering ? 200 : 150, 0, 255);
-            SDL_RenderFillRect(renderer, &buttonRect);
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(renderer, &buttonRect);
-
-            string startText = "START GAME";
-            SDL_Surface *startSurface = TTF_RenderText_Solid(largeFont, startText.c_str(), titleColor);
-            SDL_Texture *startTexture = SDL_CreateTextureFromSurface(renderer, startSurface);
-            SDL_Rect startRect = {
-                (WINDOW_WIDTH - startSurface->w) / 2,
-                WINDOW_HEIGHT - 130,
-                startSurface->w,
-                startSurface->h
-            };
-            SDL_RenderCopy(renderer, startTexture, NULL, &startRect);
-            SDL_FreeSurface(startSurface);
-            SDL_DestroyTexture(startTexture);
-
-            SDL_Color instructColor = {180, 180, 180, 255};
-            string instructText = "Click START GAME to begin";
-            SDL_Surface *instructSurface = TTF_RenderText_Solid(font, instructText.c_str(), instructColor);
-            SDL_Texture *instructTexture = SDL_CreateTextureFromSurface(renderer, instructSurface);
-            SDL_Rect instructRect = {
-                (WINDOW_WIDTH - instructSurface->w) / 2,
-                WINDOW_HEIGHT - 50,
-                instructSurface->w,
-                instructSurface->h
-            };
-            SDL_RenderCopy(renderer, instructTexture, NULL, &instructRect);
-            SDL_FreeSurface(instructSurface);
-            SDL_DestroyTexture(instructTexture);
-
-            string wrongGuessText = "Wrong guesses allowed: " + to_string(maxWrong);
-            SDL_Surface *wrongSurface = TTF_RenderText_Solid(font, wrongGuessText.c_str(), titleColor);
-            SDL_Texture *wrongTexture = SDL_CreateTextureFromSurface(renderer, wrongSurface);
-            SDL_Rect wrongRect = {
-                20,
-                20,
-                wrongSurface->w,
-                wrongSurface->h
-            };
-            SDL_RenderCopy(renderer, wrongTexture, NULL, &wrongRect);
-            SDL_FreeSurface(wrongSurface);
-            SDL_DestroyTexture(wrongTexture);
-
-            SDL_RenderPresent(renderer);
+            drawStartScreen(*canvas, *background, fontGlyphs, largeGlyphs, hugeGlyphs, mediumGlyphs, highScores, isHovering, maxWrong);
             SDL_Delay(50);
         }
 
         if (quit) break;
 
-        word = wordList[rand() % wordList.size()];
-        guessed.clear();
+        round = pickRound(wordList.current());
+        guessed.reset();
         wrongGuesses = 0;
         bool gameOver = false;
 
@@ -404,11 +1118,12 @@ int main(int argc, char *argv[])
     {
             string displayWord;
             bool wordComplete = true;
-        for (char c : word)
+        for (size_t i = 0; i < round.encoded.glyphs.size(); i++)
         {
-            if (guessed.count(c))
+            int letter = round.encoded.letters[i];
+            if (letter < 0 || guessed.test(letter))
             {
-                displayWord += c;
+                displayWord += round.encoded.glyphs[i];
             }
             else
             {
@@ -417,108 +1132,47 @@ int main(int argc, char *argv[])
             }
             displayWord += ' ';
         }
+            string guessedLetters;
+            for (int i = 0; i < static_cast<int>(round.alphabet->letters.size()); i++) {
+                if (guessed.test(i)) {
+                    guessedLetters += round.alphabet->letters[i];
+                    guessedLetters += ' ';
+                }
+            }
             cout << "\nWord: " << displayWord << endl;
-            cout << "Guessed letters: ";
-        for (char c : guessed)
-                cout << c << ' ';
+            cout << "Guessed letters: " << guessedLetters;
             cout << "\nWrong guesses: " << wrongGuesses << "/" << maxWrong << endl;
 
             if (wordComplete)
             {
-                cout << "You win! The word was: " << word << endl;
+                cout << "You win! The word was: " << round.word << endl;
                 currentStreak++;
-                int wordScore = (word.length() * 10) - (wrongGuesses * 5);
+                int wordLength = static_cast<int>(count_if(round.encoded.letters.begin(), round.encoded.letters.end(), [](int l) { return l >= 0; }));
+                int wordScore = (wordLength * 10) - (wrongGuesses * 5);
                 totalScore += wordScore;
-                SDL_SetRenderDrawColor(renderer, 0, 100, 0, 255);
-                SDL_RenderClear(renderer);
+                canvas->setDrawColor(0, 100, 0, 255);
+                canvas->clear();
                 SDL_Color textColor = {255, 255, 255, 255};
                 string streakText = "Correct! Streak: " + to_string(currentStreak);
-                SDL_Surface *streakSurface = TTF_RenderText_Solid(hugeFont, streakText.c_str(), textColor);
-                SDL_Texture *streakTexture = SDL_CreateTextureFromSurface(renderer, streakSurface);
-                SDL_Rect streakRect = {
-                    (WINDOW_WIDTH - streakSurface->w) / 2,
-                    WINDOW_HEIGHT / 2 - 50,
-                    streakSurface->w,
-                    streakSurface->h
-                };
-                SDL_RenderCopy(renderer, streakTexture, NULL, &streakRect);
-                SDL_FreeSurface(streakSurface);
-                SDL_DestroyTexture(streakTexture);
+                hugeGlyphs.drawCentered(streakText, WINDOW_HEIGHT / 2 - 50, textColor);
 
                 string scoreText = "Total Score: " + to_string(totalScore);
-                SDL_Surface *scoreSurface = TTF_RenderText_Solid(mediumFont, scoreText.c_str(), textColor);
-                SDL_Texture *scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-                SDL_Rect scoreRect = {
-                    (WINDOW_WIDTH - scoreSurface->w) / 2,
-                    WINDOW_HEIGHT / 2 + 50,
-                    scoreSurface->w,
-                    scoreSurface->h
-                };
-                SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreRect);
-                SDL_FreeSurface(scoreSurface);
-                SDL_DestroyTexture(scoreTexture);
+                mediumGlyphs.drawCentered(scoreText, WINDOW_HEIGHT / 2 + 50, textColor);
 
-                SDL_RenderPresent(renderer);
+                canvas->present();
                 SDL_Delay(1500);
 
-                string prevWord = word;
-                do {
-                    word = wordList[rand() % wordList.size()];
-                } while (word == prevWord);
-                guessed.clear();
+                round = pickRound(wordList.current(), round.word);
+                guessed.reset();
                 wrongGuesses = 0;
                 continue;
             }
 
         if (wrongGuesses >= maxWrong)
         {
-                cout << "Game Over! The word was: " << word << endl;
+                cout << "Game Over! The word was: " << round.word << endl;
                 gameOver = true;
                 updateHighScores(currentStreak);           
-                SDL_SetRenderDrawColor(renderer, 100, 0, 0, 255);
-                SDL_RenderClear(renderer);
-                SDL_GetMouseState(&mouseX, &mouseY);
-                SDL_Color gameOverColor = {255, 255, 255, 255};
-                string gameOverText = "Game Over!";
-                SDL_Surface *gameOverSurface = TTF_RenderText_Solid(hugeFont, gameOverText.c_str(), gameOverColor);
-                SDL_Texture *gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-                SDL_Rect gameOverRect = {
-                    (WINDOW_WIDTH - gameOverSurface->w) / 2,
-                    WINDOW_HEIGHT / 2 - 150,
-                    gameOverSurface->w,
-                    gameOverSurface->h
-                };
-                SDL_RenderCopy(renderer, gameOverTexture, NULL, &gameOverRect);
-                SDL_FreeSurface(gameOverSurface);
-                SDL_DestroyTexture(gameOverTexture);
-
-                // Display final stats
-                string statsText = "Words Guessed: " + to_string(currentStreak) + 
-                                      " | Final Score: " + to_string(totalScore);
-                SDL_Surface *statsSurface = TTF_RenderText_Solid(mediumFont, statsText.c_str(), gameOverColor);
-                SDL_Texture *statsTexture = SDL_CreateTextureFromSurface(renderer, statsSurface);
-                SDL_Rect statsRect = {
-                    (WINDOW_WIDTH - statsSurface->w) / 2,
-                    WINDOW_HEIGHT / 2 - 50,
-                    statsSurface->w,
-                    statsSurface->h
-                };
-                SDL_RenderCopy(renderer, statsTexture, NULL, &statsRect);
-                SDL_FreeSurface(statsSurface);
-                SDL_DestroyTexture(statsTexture);
-                string wordText = "The word was: " + word;
-                SDL_Surface *wordSurface = TTF_RenderText_Solid(mediumFont, wordText.c_str(), gameOverColor);
-                SDL_Texture *wordTexture = SDL_CreateTextureFromSurface(renderer, wordSurface);
-                SDL_Rect wordRect = {
-                    (WINDOW_WIDTH - wordSurface->w) / 2,
-                    WINDOW_HEIGHT / 2 + 50,
-                    wordSurface->w,
-                    wordSurface->h
-                };
-                SDL_RenderCopy(renderer, wordTexture, NULL, &wordRect);
-                SDL_FreeSurface(wordSurface);
-                SDL_DestroyTexture(wordTexture);
-
                 SDL_Rect mainMenuButton = {
                     (WINDOW_WIDTH - 300) / 2,
                     WINDOW_HEIGHT - 200,
@@ -533,49 +1187,7 @@ int main(int argc, char *argv[])
                     80
                 };
 
-                SDL_GetMouseState(&mouseX, &mouseY);
-                bool isHoveringMainMenu = (mouseX >= mainMenuButton.x && mouseX <= mainMenuButton.x + mainMenuButton.w &&
-                                         mouseY >= mainMenuButton.y && mouseY <= mainMenuButton.y + mainMenuButton.h);
-                bool isHoveringPlayAgain = (mouseX >= playAgainButton.x && mouseX <= playAgainButton.x + playAgainButton.w &&
-                                          mouseY >= playAgainButton.y && mouseY <= playAgainButton.y + playAgainButton.h);
-
-                SDL_SetRenderDrawColor(renderer, isHoveringMainMenu ? 0 : 0, isHoveringMainMenu ? 200 : 150, 0, 255);
-                SDL_RenderFillRect(renderer, &mainMenuButton);
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                SDL_RenderDrawRect(renderer, &mainMenuButton);
-
-                SDL_SetRenderDrawColor(renderer, isHoveringPlayAgain ? 0 : 0, isHoveringPlayAgain ? 200 : 150, 0, 255);
-                SDL_RenderFillRect(renderer, &playAgainButton);
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                SDL_RenderDrawRect(renderer, &playAgainButton);
-
-                string mainMenuText = "MAIN MENU";
-                SDL_Surface *mainMenuSurface = TTF_RenderText_Solid(mediumFont, mainMenuText.c_str(), gameOverColor);
-                SDL_Texture *mainMenuTexture = SDL_CreateTextureFromSurface(renderer, mainMenuSurface);
-                SDL_Rect mainMenuTextRect = {
-                    (WINDOW_WIDTH - mainMenuSurface->w) / 2,
-                    WINDOW_HEIGHT - 180,
-                    mainMenuSurface->w,
-                    mainMenuSurface->h
-                };
-                SDL_RenderCopy(renderer, mainMenuTexture, NULL, &mainMenuTextRect);
-                SDL_FreeSurface(mainMenuSurface);
-                SDL_DestroyTexture(mainMenuTexture);
-
-                string playAgainText = "PLAY AGAIN";
-                SDL_Surface *playAgainSurface = TTF_RenderText_Solid(mediumFont, playAgainText.c_str(), gameOverColor);
-                SDL_Texture *playAgainTexture = SDL_CreateTextureFromSurface(renderer, playAgainSurface);
-                SDL_Rect playAgainTextRect = {
-                    (WINDOW_WIDTH - playAgainSurface->w) / 2,
-                    WINDOW_HEIGHT - 80,
-                    playAgainSurface->w,
-                    playAgainSurface->h
-                };
-                SDL_RenderCopy(renderer, playAgainTexture, NULL, &playAgainTextRect);
-                SDL_FreeSurface(playAgainSurface);
-                SDL_DestroyTexture(playAgainTexture);
-
-                SDL_RenderPresent(renderer);
+                drawGameOverScreen(*canvas, hugeGlyphs, mediumGlyphs, currentStreak, totalScore, round.word, mainMenuButton, playAgainButton);
 
                 bool deciding = true;
                 while (deciding && !quit)
@@ -588,6 +1200,11 @@ int main(int argc, char *argv[])
                             quit = true;
                             deciding = false;
                         }
+                        else if (isRepaintEvent(e))
+                        {
+                            canvas->invalidate();
+                            drawGameOverScreen(*canvas, hugeGlyphs, mediumGlyphs, currentStreak, totalScore, round.word, mainMenuButton, playAgainButton);
+                        }
                         else if (e.type == SDL_MOUSEBUTTONDOWN)
                         {
                             SDL_GetMouseState(&mouseX, &mouseY);
@@ -601,8 +1218,8 @@ int main(int argc, char *argv[])
                             else if (mouseX >= playAgainButton.x && mouseX <= playAgainButton.x + playAgainButton.w &&
                                      mouseY >= playAgainButton.y && mouseY <= playAgainButton.y + playAgainButton.h)
                             {
-                                word = wordList[rand() % wordList.size()];
-                                guessed.clear();
+                                round = pickRound(wordList.current());
+                                guessed.reset();
                                 wrongGuesses = 0;
                                 currentStreak = 0;
                                 totalScore = 0;
@@ -621,88 +1238,33 @@ int main(int argc, char *argv[])
             if (e.type == SDL_QUIT)
             {
                 quit = true;
+            }
+            else if (isRepaintEvent(e))
+            {
+                canvas->invalidate();
             }
                 else if (e.type == SDL_MOUSEBUTTONDOWN)
                 {
                     SDL_GetMouseState(&mouseX, &mouseY);
             }
-            else if (e.type == SDL_KEYDOWN)
+            else if (e.type == SDL_TEXTINPUT)
             {
-                char guess = 0;
-                if (e.key.keysym.sym >= SDLK_a && e.key.keysym.sym <= SDLK_z)
-                {
-                    guess = static_cast<char>(e.key.keysym.sym);
-                }
-                if (guess && !guessed.count(guess))
+                for (char32_t cp : decodeUtf8(e.text.text))
                 {
-                    guessed.insert(guess);
-                    if (word.find(guess) == string::npos)
+                    int guess = letterIndex(*round.alphabet, cp);
+                    if (guess >= 0 && !guessed.test(guess))
                     {
-                        wrongGuesses++;
+                        guessed.set(guess);
+                        if (!round.encoded.mask.test(guess))
+                        {
+                            wrongGuesses++;
+                        }
                     }
                 }
             }
         }
 
-            // Draw game screen
-            SDL_SetRenderDrawColor(renderer, 0, 128, 0, 255);
-        SDL_RenderClear(renderer);
-        drawHangman(renderer, wrongGuesses);
-
-            // Get mouse position for hover effects
-            SDL_GetMouseState(&mouseX, &mouseY);
-
-            // Render word with larger font
-            SDL_Color wordColor = {0, 0, 0, 255};
-            string displayText = displayWord;
-            SDL_Surface *textSurface = TTF_RenderText_Solid(largeFont, displayText.c_str(), wordColor);
-            SDL_Texture *textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            SDL_Rect textRect = {
-                (WINDOW_WIDTH - textSurface->w) / 2,  // Center horizontally
-                WINDOW_HEIGHT - 150,                   // Near bottom of screen
-                textSurface->w,
-                textSurface->h
-            };
-            SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-            SDL_FreeSurface(textSurface);
-            SDL_DestroyTexture(textTexture);
-
-            // Render guessed letters with blue color
-            SDL_Color guessedColor = {100, 180, 255, 255};
-            string guessedLetters = "Letters tried: ";
-            for (char c : guessed) {
-                guessedLetters += c;
-                guessedLetters += ' ';
-            }
-            textSurface = TTF_RenderText_Solid(font, guessedLetters.c_str(), guessedColor);
-            textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            SDL_Rect guessRect = {50, 50, textSurface->w, textSurface->h};
-            SDL_RenderCopy(renderer, textTexture, NULL, &guessRect);
-            SDL_FreeSurface(textSurface);
-            SDL_DestroyTexture(textTexture);
-
-            SDL_Color wrongColor;
-            if (wrongGuesses <= 2) {
-                wrongColor = {100, 255, 100, 255}; 
-            } else if (wrongGuesses <= 4) {
-                wrongColor = {255, 255, 100, 255};
-            } else {
-                wrongColor = {255, 100, 100, 255};
-            }
-            string wrongGuessText = "Wrong guesses: " + to_string(wrongGuesses) + "/" + to_string(maxWrong);
-            textSurface = TTF_RenderText_Solid(font, wrongGuessText.c_str(), wrongColor);
-            textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            SDL_Rect wrongRect = {
-                20,
-                20,
-                textSurface->w,
-                textSurface->h
-            };
-            SDL_RenderCopy(renderer, textTexture, NULL, &wrongRect);
-            SDL_FreeSurface(textSurface);
-            SDL_DestroyTexture(textTexture);
-
-        SDL_RenderPresent(renderer);
+            drawGameScreen(*canvas, fontGlyphs, largeGlyphs, displayWord, guessedLetters, wrongGuesses, maxWrong);
 
         SDL_Delay(50);
     }
@@ -710,12 +1272,18 @@ int main(int argc, char *argv[])
 
     Mix_FreeMusic(backgroundMusic);
     Mix_CloseAudio();
-    SDL_DestroyTexture(backgroundTexture);
+    background.reset();
+    fontGlyphs.clear();
+    largeGlyphs.clear();
+    hugeGlyphs.clear();
+    mediumGlyphs.clear();
     TTF_CloseFont(font);
     TTF_CloseFont(largeFont);
     TTF_CloseFont(hugeFont);
     TTF_CloseFont(mediumFont);
-    SDL_DestroyRenderer(renderer);
+    canvas.reset();
+    if (renderer)
+        SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_Quit();
     SDL_Quit();